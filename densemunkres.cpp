@@ -0,0 +1,115 @@
+#include "densemunkres.h"
+#include <algorithm>    // std::min, std::max
+#include "assert.h"
+
+DenseMunkres::DenseMunkres(vector<entry> values, uint nrows, uint ncols)
+{
+    this->entries = values;
+    this->nrows = nrows;
+    this->ncols = ncols;
+    // The algorithm assigns every stored row, so keep the short side as rows.
+    this->transposed = nrows > ncols;
+    this->height = std::min(nrows, ncols);
+    this->width = std::max(nrows, ncols);
+
+    this->costs.assign((size_t)height*width, BIGVALUE);
+    for (uint k = 0; k < entries.size(); k++) {
+        entry &e = entries[k];
+        size_t cell = transposed ? (size_t)e.pos.j*width + e.pos.i : (size_t)e.pos.i*width + e.pos.j;
+        // Keep the cheapest of repeated entries.
+        if (e.cost < costs[cell]) {
+            costs[cell] = e.cost;
+        }
+    }
+}
+
+/*
+ * Hungarian algorithm with row and column potentials (u, v). Rows are added
+ * one at a time; for each, a shortest augmenting path is grown from the new
+ * row using the reduced costs cost[i][j] - u[i] - v[j], and the matching is
+ * flipped along it. Every pass scans a single contiguous row of costs.
+ * Columns are numbered from 1, column 0 is a virtual column holding the row
+ * currently being added.
+ */
+vector<entry> DenseMunkres::munkres() {
+    vector<double> u(height + 1, 0), v(width + 1, 0);
+    vector<uint> p(width + 1, 0);       // p[j] is the row (1-based) matched to column j, 0 if none
+    vector<uint> way(width + 1, 0);     // way[j] is the previous column in the augmenting path
+    vector<double> minv(width + 1);
+    vector<char> used(width + 1);
+
+    for (uint i = 1; i <= height; i++) {
+        p[0] = i;
+        uint j0 = 0;
+        std::fill(minv.begin(), minv.end(), INF);
+        std::fill(used.begin(), used.end(), 0);
+        do {
+            used[j0] = 1;
+            uint i0 = p[j0];
+            uint j1 = 0;
+            double delta = INF;
+            const double *row = &costs[(size_t)(i0 - 1)*width] - 1;
+            double ui0 = u[i0];
+            for (uint j = 1; j <= width; j++) {
+                if (!used[j]) {
+                    double cur = row[j] - ui0 - v[j];
+                    if (cur < minv[j]) {
+                        minv[j] = cur;
+                        way[j] = j0;
+                    }
+                    if (minv[j] < delta) {
+                        delta = minv[j];
+                        j1 = j;
+                    }
+                }
+            }
+            assert(j1 != 0);
+            for (uint j = 0; j <= width; j++) {
+                if (used[j]) {
+                    u[p[j]] += delta;
+                    v[j] -= delta;
+                } else {
+                    minv[j] -= delta;
+                }
+            }
+            j0 = j1;
+        } while (p[j0] != 0);
+        // Flip the matching along the augmenting path.
+        do {
+            uint j1 = way[j0];
+            p[j0] = p[j1];
+            j0 = j1;
+        } while (j0 != 0);
+    }
+
+    // matched_column[i] is the problem column assigned to problem row i.
+    vector<uint> matched_column(nrows, NOTFOUND);
+    for (uint j = 1; j <= width; j++) {
+        if (p[j] == 0) continue;
+        uint r = p[j] - 1, c = j - 1;
+        if (transposed) {
+            matched_column[c] = r;
+        } else {
+            matched_column[r] = c;
+        }
+    }
+    // Recover the matched entries. Missing cells have no entry, and among
+    // repeated entries we take the one whose cost was stored.
+    vector<uint> chosen(nrows, NOTFOUND);
+    for (uint k = 0; k < entries.size(); k++) {
+        entry &e = entries[k];
+        if (matched_column[e.pos.i] != e.pos.j || chosen[e.pos.i] != NOTFOUND) continue;
+        size_t cell = transposed ? (size_t)e.pos.j*width + e.pos.i : (size_t)e.pos.i*width + e.pos.j;
+        if (e.cost == costs[cell]) {
+            chosen[e.pos.i] = k;
+        }
+    }
+    // Report the matching row by row, like the sparse engine does.
+    vector<entry> res;
+    for (uint i = 0; i < nrows; i++) {
+        if (chosen[i] != NOTFOUND) {
+            res.push_back(entries[chosen[i]]);
+        }
+    }
+    return res;
+}
@@ -0,0 +1,34 @@
+#ifndef DENSEMUNKRES_H
+#define DENSEMUNKRES_H
+
+#include "matrix.h"
+
+/*
+   Dense counterpart of Munkres, for nearly complete cost matrices.
+   The costs are stored row-major in a height x width array, with
+   height = min(nrows, ncols) and width = max(nrows, ncols): tall problems
+   are stored transposed, so no padding is ever needed. Missing entries
+   cost BIGVALUE, which plays the same role as the extra columns of the
+   sparse Matrix: a match on a missing entry is left out of the result.
+   As with Matrix, the user should remap the rows and columns first.
+*/
+class DenseMunkres
+{
+public:
+    DenseMunkres(vector<entry> values, uint nrows, uint ncols);
+
+    // Run the algorithm, return optimal matching
+    vector<entry> munkres();
+
+    uint nrows, ncols;
+    uint height, width;
+    // true if the rows of costs are the columns of the problem.
+    bool transposed;
+
+protected:
+    vector<entry> entries;
+    // costs[r*width+c] is the cost of stored cell [r,c], BIGVALUE if missing.
+    vector<double> costs;
+};
+
+#endif // DENSEMUNKRES_H
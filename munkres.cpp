@@ -1,9 +1,12 @@
 #include "munkres.h"
+#include "densemunkres.h"
 #include "limits.h"
 #include "assert.h"
 
 #include "iostream"
 #include <map>
+#include <deque>
+#include <algorithm>
 
 ostream& operator <<(ostream &s, Munkres *m) {
     for (uint i = 0; i < m->matrix->nentries(); i++) {
@@ -254,8 +257,112 @@ short Munkres::step_6() {
     return 4;
 }
 
+// Orders vertices of the bipartite graph by increasing degree.
+struct by_degree {
+    const vector<uint> &degree;
+    by_degree(const vector<uint> &degree) : degree(degree) {}
+    bool operator()(uint a, uint b) const { return degree[a] < degree[b]; }
+};
+
+/*
+ * Relabel the (already remapped) rows and columns for memory locality.
+ * Rows and columns are the two sides of a bipartite graph; we walk it in
+ * Cuthill-McKee order (BFS from a minimum degree row, visiting neighbours
+ * by increasing degree) and number the rows and columns in the order they
+ * are reached. Connected rows and columns end up with nearby indices, so
+ * the row_adds/column_adds/covered_* lookups done on every scan stay close
+ * together. The maps are updated so that i_map[new_i] is still the original row.
+ */
+static void reorder_for_locality(vector<entry> &remapped, vector<uint> &i_map, vector<uint> &j_map) {
+    uint nrows = i_map.size();
+    uint ncols = j_map.size();
+    // Bipartite adjacency, in compressed form. Vertices 0..nrows-1 are rows,
+    // nrows..nrows+ncols-1 are columns.
+    uint nvertices = nrows + ncols;
+    vector<uint> start(nvertices + 1, 0);
+    for (uint index = 0; index < remapped.size(); index++) {
+        entry &e = remapped[index];
+        start[e.pos.i + 1]++;
+        start[nrows + e.pos.j + 1]++;
+    }
+    for (uint v = 0; v < nvertices; v++) {
+        start[v+1] += start[v];
+    }
+    vector<uint> adjacent(start[nvertices]);
+    vector<uint> fill(start.begin(), start.end() - 1);
+    for (uint index = 0; index < remapped.size(); index++) {
+        entry &e = remapped[index];
+        adjacent[fill[e.pos.i]++] = nrows + e.pos.j;
+        adjacent[fill[nrows + e.pos.j]++] = e.pos.i;
+    }
+    vector<uint> degree(nvertices);
+    for (uint v = 0; v < nvertices; v++) {
+        degree[v] = start[v+1] - start[v];
+    }
+
+    // Rows sorted by degree, to pick the starting point of each component.
+    vector<uint> rows_by_degree(nrows);
+    for (uint i = 0; i < nrows; i++) {
+        rows_by_degree[i] = i;
+    }
+    std::stable_sort(rows_by_degree.begin(), rows_by_degree.end(), by_degree(degree));
+
+    vector<uint> new_label(nvertices, NOTFOUND);
+    vector<bool> visited(nvertices, false);
+    uint next_i = 0, next_j = 0;
+    deque<uint> queue;
+    vector<uint> neighbours;
+    for (uint r = 0; r < nrows; r++) {
+        uint root = rows_by_degree[r];
+        if (visited[root]) continue;
+        visited[root] = true;
+        queue.push_back(root);
+        while (!queue.empty()) {
+            uint v = queue.front();
+            queue.pop_front();
+            new_label[v] = v < nrows ? next_i++ : next_j++;
+            neighbours.clear();
+            for (uint k = start[v]; k < start[v+1]; k++) {
+                uint w = adjacent[k];
+                if (!visited[w]) {
+                    visited[w] = true;
+                    neighbours.push_back(w);
+                }
+            }
+            std::stable_sort(neighbours.begin(), neighbours.end(), by_degree(degree));
+            queue.insert(queue.end(), neighbours.begin(), neighbours.end());
+        }
+    }
+    assert(next_i == nrows && next_j == ncols);
+
+    // Fold the permutation into the remapped entries and the output maps.
+    for (uint index = 0; index < remapped.size(); index++) {
+        entry &e = remapped[index];
+        e.pos.i = new_label[e.pos.i];
+        e.pos.j = new_label[nrows + e.pos.j];
+    }
+    vector<uint> old_i_map = i_map, old_j_map = j_map;
+    for (uint i = 0; i < nrows; i++) {
+        i_map[new_label[i]] = old_i_map[i];
+    }
+    for (uint j = 0; j < ncols; j++) {
+        j_map[new_label[nrows + j]] = old_j_map[j];
+    }
+}
+
+// Whether a remapped nrows x ncols problem with nentries entries should use
+// the dense engine.
+// DenseMunkres stores tall problems transposed, so it allocates exactly
+// nrows*ncols cells.
+static bool use_dense(uint nentries, uint nrows, uint ncols, double dense_threshold) {
+    double cells = (double)nrows * ncols;
+    return nentries >= dense_threshold * cells && cells <= DENSE_MAX_CELLS;
+}
+
 // Remap the indices in entries to 0..n, to eliminate empty rows and columns.
-vector<entry> munkres(vector<entry> &entries) {
+// If reorder is set, the rows and columns of sparse problems are also
+// relabelled for locality (see reorder_for_locality).
+vector<entry> munkres(vector<entry> &entries, bool reorder, double dense_threshold) {
     if (entries.size() <= 1) {
         return entries;
     }
@@ -293,8 +400,16 @@ vector<entry> munkres(vector<entry> &entries) {
         remapped.push_back(n);
     }
 
-    Munkres m(remapped);
-    optimal = m.munkres();
+    if (use_dense(remapped.size(), i_map.size(), j_map.size(), dense_threshold)) {
+        DenseMunkres m(remapped, i_map.size(), j_map.size());
+        optimal = m.munkres();
+    } else {
+        if (reorder) {
+            reorder_for_locality(remapped, i_map, j_map);
+        }
+        Munkres m(remapped);
+        optimal = m.munkres();
+    }
     for (uint index = 0; index<optimal.size(); index++) {
         entry &e = optimal[index];
         e.pos.i = i_map[e.pos.i];
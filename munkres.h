@@ -4,6 +4,13 @@
 #include "matrix.h"
 #include <set>
 
+// munkres() switches to the dense engine when at least this fraction of the
+// (remapped) cost matrix is present. Below it, wide or banded problems are
+// faster with the sparse engine.
+#define DENSE_THRESHOLD 0.15
+// ... and the dense matrix is no larger than this many cells (128MB of costs).
+#define DENSE_MAX_CELLS (1u << 24)
+
 
 class Munkres
 {
@@ -36,6 +43,11 @@ public:
     uint last_primed_index;
 };
 
-vector<entry> munkres(vector<entry> &values);
+// Solve the assignment problem described by values.
+// If reorder is true, rows and columns are relabelled (Cuthill-McKee order)
+// before solving to improve memory locality on large problems.
+// Nearly complete problems are solved with DenseMunkres when their density
+// is at least dense_threshold (use a value above 1 to always stay sparse).
+vector<entry> munkres(vector<entry> &values, bool reorder = false, double dense_threshold = DENSE_THRESHOLD);
 
 #endif // MUNKRES_H
@@ -2,6 +2,7 @@
 
 #include "munkres.h"
 #include <iostream>
+#include <new>
 
 #ifndef PyInt_Check
 #define PyInt_Check(x) PyLong_Check(x)
@@ -12,7 +13,7 @@
 
 using namespace std;
 
-bool marshal_pyargs_to_entries(PyObject *self, PyObject *args, vector<entry> &entries, bool &with_cost, bool &with_idx) {
+bool marshal_pyargs_to_entries(PyObject *self, PyObject *args, vector<entry> &entries, bool &with_cost, bool &with_idx, bool &reorder, double &dense_threshold) {
     PyObject *py_entries_arg;
     PyObject *py_entries;
     PyObject *py_entry_seq;    
@@ -21,15 +22,18 @@ bool marshal_pyargs_to_entries(PyObject *self, PyObject *args, vector<entry> &en
     int i, len, slen;
     int with_cost_int = 0;
     int with_idx_int = 0;
+    int reorder_int = 0;
+    dense_threshold = DENSE_THRESHOLD;
     
     char* wrong_arg_msg = "Expected a sequence of (i,j,cost)";
 
     /* Marshal the list of tuples in *args into the entries vector */
-    if (!PyArg_ParseTuple(args, "O|ii", &py_entries_arg,&with_cost_int,&with_idx_int))
+    if (!PyArg_ParseTuple(args, "O|iiid", &py_entries_arg,&with_cost_int,&with_idx_int,&reorder_int,&dense_threshold))
         return false;
     
     with_cost = (with_cost_int != 0);
     with_idx = (with_idx_int != 0);
+    reorder = (reorder_int != 0);
 
     py_entries = PySequence_Fast(py_entries_arg, wrong_arg_msg);
     if (!py_entries) {
@@ -106,18 +110,43 @@ munkres_munkres(PyObject *self, PyObject *args)
     vector<entry> entries;
     bool with_cost;
     bool with_idx;
-    if (!marshal_pyargs_to_entries(self, args, entries, with_cost, with_idx)) {
+    bool reorder;
+    double dense_threshold;
+    if (!marshal_pyargs_to_entries(self, args, entries, with_cost, with_idx, reorder, dense_threshold)) {
         return NULL;
     }
-    vector<entry> optimal = munkres(entries);
+    vector<entry> optimal;
+    bool out_of_memory = false;
+    // The solver only touches its own data, so let other Python threads run
+    // while it works. This allows several problems to be solved concurrently
+    // from a thread pool (e.g. asyncio's loop.run_in_executor).
+    // No exception may cross this function, so allocation failures are
+    // turned into a MemoryError once the GIL is held again.
+    Py_BEGIN_ALLOW_THREADS
+    try {
+        optimal = munkres(entries, reorder, dense_threshold);
+    } catch (std::bad_alloc &) {
+        out_of_memory = true;
+    }
+    Py_END_ALLOW_THREADS
+    if (out_of_memory) {
+        return PyErr_NoMemory();
+    }
     PyObject *py_result = marshal_entries_to_list(optimal, with_cost, with_idx);
     return py_result;
 }
 
-char* munkres_fnc_doc = "munkres([(i,j,cost)...], return_costs=False, return_idx=False).\n"
+char* munkres_fnc_doc = "munkres([(i,j,cost)...], return_costs=False, return_idx=False, reorder=False, dense_threshold=0.15).\n"
                     "Returns the optimal matching as a list of tuples [(idx, i, j, cost)...].\n"
                     "Both idx and cost are excluded from the return tuples by default "
-                    "(return_costs and return_idx)"
+                    "(return_costs and return_idx).\n"
+                    "If reorder is true, rows and columns are relabelled for memory locality "
+                    "before solving (experimental; the effect on speed depends on the problem).\n"
+                    "Problems where at least a dense_threshold fraction of the cost matrix "
+                    "is present are solved with a dense engine instead (if not too large); "
+                    "use dense_threshold > 1 to always use the sparse one.\n"
+                    "The GIL is released while solving, so calls from different threads "
+                    "run in parallel."
                     "";
   
 static PyMethodDef MunkresMethods[] = {
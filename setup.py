@@ -1,7 +1,7 @@
 from distutils.core import setup, Extension
 
 module1 = Extension('csparsemunkres',
-                    sources = ['pythonmodule.cpp', 'matrix.cpp', 'munkres.cpp'])
+                    sources = ['pythonmodule.cpp', 'matrix.cpp', 'munkres.cpp', 'densemunkres.cpp'])
 
 setup (name = 'csparsemunkres',
         version = '1.0',